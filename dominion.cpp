@@ -1,3 +1,4 @@
+#include <cstdint>
 #include <iostream>
 #include "sdlandnet.hpp"
 
@@ -36,6 +37,12 @@ constexpr int RESET_KEY = Events::LETTERS['r' - 'a'];
 // The key used to display the game info/
 constexpr int INFO_KEY = Events::ENTER;
 
+// The key used to save a snapshot of the game.
+constexpr int SAVE_KEY = Events::LETTERS['s' - 'a'];
+
+// The key used to load the saved snapshot.
+constexpr int LOAD_KEY = Events::LETTERS['l' - 'a'];
+
 // The number of players.
 constexpr int PLAYERS = 2;
 
@@ -47,6 +54,124 @@ constexpr Sprite::Colour PLAYER_COLOURS[PLAYERS] = {
 
 // The number to represent an empty grid cell.
 constexpr int EMPTY = -1;
+
+// The number of bytes used to store the grid, turn and expansion flags.
+constexpr int STATE_SIZE = CELLS * CELLS + 2;
+
+// The number of bytes used to store the move checksum.
+constexpr int CHECKSUM_SIZE = 4;
+
+// The number of bytes in a snapshot.
+constexpr int SNAPSHOT_SIZE = STATE_SIZE + CHECKSUM_SIZE;
+
+// The initial value of the move checksum (the FNV-1a offset basis).
+constexpr std::uint32_t CHECKSUM_BASIS = 2166136261u;
+
+// The multiplier used to mix each byte into the move checksum (the FNV-1a prime).
+constexpr std::uint32_t CHECKSUM_PRIME = 16777619u;
+
+// The expansion flags are packed into a single byte.
+static_assert(PLAYERS <= 8, "Too many players for the snapshot format.");
+//}
+
+// TYPES
+//{
+// The grid's array representation.
+using Grid = std::array<std::array<int, CELLS>, CELLS>;
+
+// A compact binary copy of the game state.
+using Snapshot = std::array<unsigned char, SNAPSHOT_SIZE>;
+//}
+
+// FUNCTIONS
+//{
+/* Packs the game state into a snapshot.
+
+   Each cell is stored in a byte (0 for empty, player + 1 otherwise),
+    followed by the turn, the expansion flags as a bitmask
+    and the move checksum (least significant byte first).
+ */
+Snapshot save(
+    const Grid& grid,
+    int turn,
+    const std::array<bool, PLAYERS>& expanded,
+    std::uint32_t checksum
+) {
+    Snapshot snapshot;
+    
+    // The grid is stored column by column.
+    for (int i = 0; i < CELLS; ++i) {
+        for (int j = 0; j < CELLS; ++j) {
+            snapshot[i * CELLS + j] = grid[i][j] + 1;
+        }
+    }
+    
+    // The turn is stored after the grid.
+    snapshot[STATE_SIZE - 2] = turn;
+    
+    // The expansion flags are stored as a bitmask.
+    unsigned char flags = 0;
+    
+    for (int i = 0; i < PLAYERS; ++i) {
+        if (expanded[i]) {
+            flags |= 1 << i;
+        }
+    }
+    
+    snapshot[STATE_SIZE - 1] = flags;
+    
+    // The checksum is stored after the state.
+    for (int i = 0; i < CHECKSUM_SIZE; ++i) {
+        snapshot[STATE_SIZE + i] = checksum >> 8 * i & 0xFF;
+    }
+    
+    return snapshot;
+}
+
+// Restores the game state from a snapshot.
+void load(
+    const Snapshot& snapshot,
+    Grid& grid,
+    int& turn,
+    std::array<bool, PLAYERS>& expanded,
+    std::uint32_t& checksum
+) {
+    // The grid is restored column by column.
+    for (int i = 0; i < CELLS; ++i) {
+        for (int j = 0; j < CELLS; ++j) {
+            grid[i][j] = snapshot[i * CELLS + j] - 1;
+        }
+    }
+    
+    // The turn is restored.
+    turn = snapshot[STATE_SIZE - 2];
+    
+    // The expansion flags are unpacked.
+    for (int i = 0; i < PLAYERS; ++i) {
+        expanded[i] = snapshot[STATE_SIZE - 1] >> i & 1;
+    }
+    
+    // The checksum is restored.
+    checksum = 0;
+    
+    for (int i = 0; i < CHECKSUM_SIZE; ++i) {
+        checksum |= static_cast<std::uint32_t>(snapshot[STATE_SIZE + i]) << 8 * i;
+    }
+}
+
+/* Mixes the state stored in a snapshot into the move checksum.
+
+   The checksum is rolled after every move, so two games only share a checksum
+    if they passed through the same states (barring collisions).
+   The snapshot's own stored checksum is not mixed in.
+ */
+std::uint32_t roll(std::uint32_t checksum, const Snapshot& snapshot) {
+    for (int i = 0; i < STATE_SIZE; ++i) {
+        checksum = (checksum ^ snapshot[i]) * CHECKSUM_PRIME;
+    }
+    
+    return checksum;
+}
 //}
 
 /* A board game by Chigozie Agomo.
@@ -66,7 +191,8 @@ int main(int argc, char** argv) {
     std::cout
         << '\n' << "Dominion by Chigozie Agomo." << "\n\n" << System::info()
         << "\n\nLeft click: deploy.\nRight click: expand (not twice in a row).\n"
-        << "Middle click: unite.\nEnter: view game info.\nR: restart.\n";
+        << "Middle click: unite.\nEnter: view game info.\nR: restart.\n"
+        << "S: save snapshot.\nL: load snapshot.\n";
     ;
     
     // The required sub-systems are initialised.
@@ -101,7 +227,7 @@ int main(int argc, char** argv) {
         display.update();
         
         // The grid's array representation.
-        std::array<std::array<int, CELLS>, CELLS> grid;
+        Grid grid;
         
         // The grid is emptied.
         for (int i = 0; i < CELLS; ++i) {
@@ -117,7 +243,13 @@ int main(int argc, char** argv) {
         int turn = 0;
         
         // True if the corresponding player expanded last turn.
-        std::array<bool, PLAYERS> expanded;
+        std::array<bool, PLAYERS> expanded = {};
+        
+        // The checksum of every state the game has passed through.
+        std::uint32_t checksum = CHECKSUM_BASIS;
+        
+        // The saved snapshot (initially the starting position).
+        Snapshot snapshot = save(grid, turn, expanded, checksum);
         
         // Loop to handle user input.
         while (true) {
@@ -153,6 +285,12 @@ int main(int argc, char** argv) {
                 
                 // The first player takes their turn.
                 turn = 0;
+                
+                // Every player can expand.
+                expanded = {};
+                
+                // The checksum is reset.
+                checksum = CHECKSUM_BASIS;
         
                 // The grid is emptied.
                 for (int i = 0; i < CELLS; ++i) {
@@ -195,7 +333,44 @@ int main(int argc, char** argv) {
                 }
                 
                 // The current player's turn is displayed.
-                std::cout << "\nIt is player " << turn + 1 << "'s turn.\n\n";
+                std::cout << "\nIt is player " << turn + 1 << "'s turn.\n";
+                
+                // The move checksum is displayed.
+                std::cout << "Checksum: " << std::hex << checksum << std::dec << "\n\n";
+            }
+            
+            // The player chose to save the game.
+            else if (event.type() == Event::KEY_PRESS && event.key() == SAVE_KEY) {
+                snapshot = save(grid, turn, expanded, checksum);
+            }
+            
+            // The player chose to load the saved game.
+            else if (event.type() == Event::KEY_PRESS && event.key() == LOAD_KEY) {
+                // The game state is restored.
+                load(snapshot, grid, turn, expanded, checksum);
+                
+                // The grid is redrawn.
+                for (int i = 0; i < CELLS; ++i) {
+                    // The x coordinate of the rectangle is set.
+                    hole.set_x(i * CELL_SIZE + LINE_WIDTH);
+                    
+                    for (int j = 0; j < CELLS; ++j) {
+                        // The y coordinate of the rectangle is set.
+                        hole.set_y(j * CELL_SIZE + LINE_WIDTH);
+                        
+                        // The cell's interior is drawn.
+                        if (grid[i][j] == EMPTY) {
+                            display.fill(hole, BACKGROUND_COLOUR);
+                        }
+                        
+                        else {
+                            display.fill(hole, PLAYER_COLOURS[grid[i][j]]);
+                        }
+                    }
+                }
+                
+                // The restored board is displayed.
+                display.update();
             }
             
             // The player chose to deploy troops.
@@ -227,6 +402,9 @@ int main(int argc, char** argv) {
                     
                     // The next player takes their turn.
                     turn = (turn + 1) % PLAYERS;
+                    
+                    // The new state is mixed into the checksum.
+                    checksum = roll(checksum, save(grid, turn, expanded, checksum));
                 }
             }
             
@@ -301,6 +479,9 @@ int main(int argc, char** argv) {
                     
                     // The next player takes their turn.
                     turn = (turn + 1) % PLAYERS;
+                    
+                    // The new state is mixed into the checksum.
+                    checksum = roll(checksum, save(grid, turn, expanded, checksum));
                 }
             }
             
@@ -585,6 +766,9 @@ int main(int argc, char** argv) {
                     
                     // The next player takes their turn.
                     turn = (turn + 1) % PLAYERS;
+                    
+                    // The new state is mixed into the checksum.
+                    checksum = roll(checksum, save(grid, turn, expanded, checksum));
                 }
             }
         }